@@ -3,12 +3,35 @@
 
 namespace com { namespace cutehacks { namespace gel {
 
-Collection::Collection(QObject *parent) : QSortFilterProxyModel(parent)
+static const char * const STATS_NAMES[] = {
+    "comparator",
+    "filter",
+    "sortPass",
+    "reset"
+};
+
+Collection::Collection(QObject *parent) :
+    QSortFilterProxyModel(parent),
+    m_stats(STATS_NAMES, StatsCounterCount),
+    m_pendingUpdates(0),
+    m_updateDelay(-1),
+    m_caseSensitiveSort(true),
+    m_localeAwareSort(false),
+    m_descendingSort(false)
 {
+    m_stats.setOwner(this);
+
+    m_updateTimer.setSingleShot(true);
+    connect(&m_updateTimer, SIGNAL(timeout()), this, SLOT(flush()));
+
     connect(this, SIGNAL(rowsRemoved(QModelIndex,int,int)),
             this, SLOT(emitCountChanged()));
     connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)),
             this, SLOT(emitCountChanged()));
+    connect(this, SIGNAL(layoutAboutToBeChanged()),
+            this, SLOT(sortStarted()));
+    connect(this, SIGNAL(layoutChanged()),
+            this, SLOT(sortFinished()));
 
     sort(0);
 }
@@ -25,16 +48,23 @@ QJSValue Collection::filter() const
 
 JsonListModel *Collection::model() const
 {
+    if (Collection *collection = source())
+        return collection->model();
     return qobject_cast<JsonListModel*>(sourceModel());
 }
 
+Collection *Collection::source() const
+{
+    return qobject_cast<Collection*>(sourceModel());
+}
+
 void Collection::setComparator(QJSValue comparator)
 {
     if (m_comparator.strictlyEquals(comparator))
         return;
 
     m_comparator = comparator;
-    updateModel();
+    scheduleUpdate(SortInvalidated);
     emit comparatorChanged(comparator);
 }
 
@@ -44,33 +74,97 @@ void Collection::setFilter(QJSValue filter)
         return;
 
     m_filter = filter;
-    invalidateFilter();
+    scheduleUpdate(FilterInvalidated);
     emit filterChanged(filter);
 }
 
 void Collection::setModel(JsonListModel *model)
 {
-    JsonListModel *oldModel = qobject_cast<JsonListModel*>(sourceModel());
-    if (oldModel == model)
+    if (sourceModel() == model)
         return;
 
-    if (oldModel) {
-        disconnect(oldModel, SIGNAL(rolesChanged()),
-                   this, SLOT(rolesChanged()));
+    Collection *oldSource = source();
+    if (oldSource) {
+        disconnect(oldSource, SIGNAL(modelChanged(JsonListModel*)),
+                   this, SLOT(sourceModelChanged()));
     }
 
     setSourceModel(model);
-    updateModel();
-    connect(model, SIGNAL(rolesChanged()), this, SLOT(rolesChanged()));
-    connect(model, SIGNAL(countChanged(int)), this, SLOT(emitCountChanged()));
+    connectModel();
 
+    if (oldSource)
+        emit sourceChanged(0);
     emit modelChanged(model);
 }
 
+void Collection::setSource(Collection *source)
+{
+    if (sourceModel() == source)
+        return;
+
+    for (Collection *c = source; c; c = c->source()) {
+        if (c == this) {
+            qWarning("Collection can not use itself as source");
+            return;
+        }
+    }
+
+    Collection *oldSource = this->source();
+    if (oldSource) {
+        disconnect(oldSource, SIGNAL(modelChanged(JsonListModel*)),
+                   this, SLOT(sourceModelChanged()));
+    }
+
+    setSourceModel(source);
+    if (source) {
+        connect(source, SIGNAL(modelChanged(JsonListModel*)),
+                this, SLOT(sourceModelChanged()));
+    }
+    connectModel();
+
+    emit sourceChanged(source);
+    emit modelChanged(model());
+}
+
+void Collection::sourceModelChanged()
+{
+    connectModel();
+    emit modelChanged(model());
+}
+
+void Collection::connectModel()
+{
+    // Chained collections listen to the JsonListModel at the root of the
+    // chain since that is where the roles are defined
+    JsonListModel *model = this->model();
+    if (m_connectedModel != model) {
+        if (m_connectedModel) {
+            disconnect(m_connectedModel, SIGNAL(rolesChanged()),
+                       this, SLOT(rolesChanged()));
+            disconnect(m_connectedModel, SIGNAL(countChanged(int)),
+                       this, SLOT(emitCountChanged()));
+        }
+        m_connectedModel = model;
+        if (model) {
+            connect(model, SIGNAL(rolesChanged()), this, SLOT(rolesChanged()));
+            connect(model, SIGNAL(countChanged(int)), this, SLOT(emitCountChanged()));
+        }
+    }
+    updateModel();
+}
+
+QJSValue Collection::sourceAt(int sourceRow) const
+{
+    if (Collection *collection = source())
+        return collection->at(sourceRow);
+    return model()->at(sourceRow);
+}
+
 void Collection::rolesChanged()
 {
+    StatsTimer timer(m_stats, ResetCounter);
     resetInternalData();
-    updateModel();
+    scheduleUpdate(SortRoleInvalidated);
 }
 
 void Collection::emitCountChanged()
@@ -78,6 +172,43 @@ void Collection::emitCountChanged()
     emit countChanged(rowCount());
 }
 
+void Collection::sortStarted()
+{
+    if (m_stats.isEnabled())
+        m_sortTimer.start();
+}
+
+void Collection::sortFinished()
+{
+    if (m_stats.isEnabled() && m_sortTimer.isValid()) {
+        m_stats.record(SortPassCounter, m_sortTimer.nsecsElapsed());
+        m_sortTimer.invalidate();
+    }
+}
+
+bool Collection::statsEnabled() const
+{
+    return m_stats.isEnabled();
+}
+
+void Collection::setStatsEnabled(bool statsEnabled)
+{
+    if (statsEnabled == m_stats.isEnabled())
+        return;
+    m_stats.setEnabled(statsEnabled);
+    emit statsEnabledChanged();
+}
+
+QVariantMap Collection::stats() const
+{
+    return m_stats.toVariantMap();
+}
+
+void Collection::resetStats()
+{
+    m_stats.reset();
+}
+
 void Collection::updateModel()
 {
     if (model() && m_comparator.isString()) {
@@ -90,8 +221,9 @@ void Collection::updateModel()
 bool Collection::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
     if (m_filter.isCallable()) {
+        StatsTimer timer(m_stats, FilterCounter);
         QJSValue result = m_filter.call(QJSValueList()
-                                        << model()->at(source_row)
+                                        << sourceAt(source_row)
                                         << source_row);
         return result.toBool();
     } else {
@@ -101,24 +233,109 @@ bool Collection::filterAcceptsRow(int source_row, const QModelIndex &source_pare
 
 bool Collection::lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const
 {
+    // The proxy always sorts in ascending order, descending order is applied
+    // here so that changing it does not cause a sort pass of its own
+    const QModelIndex &l = m_descendingSort ? source_right : source_left;
+    const QModelIndex &r = m_descendingSort ? source_left : source_right;
+
     if (m_comparator.isCallable()) {
-        QJSValue left = model()->at(source_left.row());
-        QJSValue right = model()->at(source_right.row());
+        StatsTimer timer(m_stats, ComparatorCounter);
+        QJSValue left = sourceAt(l.row());
+        QJSValue right = sourceAt(r.row());
         QJSValue result = m_comparator.call(QJSValueList() << left << right);
         return result.toBool();
-    } else {
-        return QSortFilterProxyModel::lessThan(source_left, source_right);
     }
+
+    QVariant left = l.data(sortRole());
+    QVariant right = r.data(sortRole());
+    if (left.type() == QVariant::String && right.type() == QVariant::String) {
+        if (m_localeAwareSort) {
+            if (m_caseSensitiveSort)
+                return QString::localeAwareCompare(left.toString(), right.toString()) < 0;
+            return QString::localeAwareCompare(left.toString().toLower(),
+                                               right.toString().toLower()) < 0;
+        }
+        Qt::CaseSensitivity cs = m_caseSensitiveSort
+                ? Qt::CaseSensitive
+                : Qt::CaseInsensitive;
+        return QString::compare(left.toString(), right.toString(), cs) < 0;
+    }
+    return QSortFilterProxyModel::lessThan(l, r);
 }
 
 QJSValue Collection::at(int row) const
 {
     QModelIndex m = index(row, 0);
     QModelIndex source = mapToSource(m);
-    return model()->at(source.row());
+    return sourceAt(source.row());
 }
 
 void Collection::reSort()
+{
+    scheduleUpdate(SortInvalidated);
+}
+
+void Collection::reFilter()
+{
+    scheduleUpdate(FilterInvalidated);
+}
+
+int Collection::updateDelay() const
+{
+    return m_updateDelay;
+}
+
+void Collection::setUpdateDelay(int updateDelay)
+{
+    if (updateDelay == m_updateDelay)
+        return;
+
+    m_updateDelay = updateDelay;
+    if (m_updateDelay < 0)
+        flush();
+    emit updateDelayChanged(updateDelay);
+}
+
+void Collection::scheduleUpdate(int updates)
+{
+    m_pendingUpdates |= updates;
+
+    if (m_updateDelay < 0) {
+        flush();
+        return;
+    }
+
+    // Don't restart a running timer, all invalidations that arrive before it
+    // fires are handled by the same pass
+    if (!m_updateTimer.isActive())
+        m_updateTimer.start(m_updateDelay);
+}
+
+void Collection::flush()
+{
+    m_updateTimer.stop();
+
+    int updates = m_pendingUpdates;
+    m_pendingUpdates = 0;
+
+    if (updates & FilterInvalidated)
+        invalidateFilter();
+    if (updates & (SortRoleInvalidated | SortInvalidated))
+        applySort(updates & SortInvalidated);
+}
+
+void Collection::applySort(bool force)
+{
+    // Case sensitivity, locale awareness and order are applied in lessThan(),
+    // so the only setter that sorts is setSortRole(). Changing several sort
+    // parameters at once results in a single pass.
+    int role = sortRole();
+    updateModel();
+    if (force && role == sortRole())
+        doSort();
+}
+
+void Collection::doSort()
 {
     if (dynamicSortFilter()) {
         // Workaround: If dynamic_sortfilter == true, sort(0) will not (always)
@@ -129,9 +346,4 @@ void Collection::reSort()
     }
 }
 
-void Collection::reFilter()
-{
-    invalidateFilter();
-}
-
 } } }
@@ -1,7 +1,10 @@
 #ifndef COLLECTION_H
 #define COLLECTION_H
 
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QPointer>
 #include <QtCore/QSortFilterProxyModel>
+#include <QtCore/QTimer>
 #include <QtQml/QJSValue>
 
 #include "jsonlistmodel.h"
@@ -18,7 +21,10 @@ class Collection : public QSortFilterProxyModel
     Q_PROPERTY(bool caseSensitiveSort READ caseSensitiveSort WRITE setCaseSensitiveSort NOTIFY caseSensitiveSortChanged)
     Q_PROPERTY(bool localeAwareSort READ localeAwareSort WRITE setLocaleAwareSort NOTIFY localeAwareSortChanged)
     Q_PROPERTY(com::cutehacks::gel::JsonListModel* model READ model WRITE setModel NOTIFY modelChanged)
+    Q_PROPERTY(com::cutehacks::gel::Collection* source READ source WRITE setSource NOTIFY sourceChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int updateDelay READ updateDelay WRITE setUpdateDelay NOTIFY updateDelayChanged)
+    Q_PROPERTY(bool statsEnabled READ statsEnabled WRITE setStatsEnabled NOTIFY statsEnabledChanged)
 
 public:
     Collection(QObject *parent = 0);
@@ -26,61 +32,71 @@ public:
     QJSValue comparator() const;
     QJSValue filter() const;
     JsonListModel *model() const;
+    Collection *source() const;
 
     Q_INVOKABLE QJSValue at(int) const;
 
     Q_INVOKABLE void reSort();
     Q_INVOKABLE void reFilter();
 
+    int updateDelay() const;
+    void setUpdateDelay(int updateDelay);
+
+    Q_INVOKABLE QVariantMap stats() const;
+    Q_INVOKABLE void resetStats();
+    bool statsEnabled() const;
+    void setStatsEnabled(bool statsEnabled);
+
     inline bool caseSensitiveSort() const
     {
-        return sortCaseSensitivity() == Qt::CaseSensitive;
+        return m_caseSensitiveSort;
     }
 
     inline bool localeAwareSort() const
     {
-        return isSortLocaleAware();
+        return m_localeAwareSort;
     }
 
     inline bool descendingSort() const
     {
-        return sortOrder() == Qt::DescendingOrder;
+        return m_descendingSort;
     }
 
     inline int count() const { return rowCount(); }
 
 public slots:
+    void flush();
     void setComparator(QJSValue comparator);
     void setFilter(QJSValue filter);
     void setModel(JsonListModel* model);
+    void setSource(Collection* source);
     void setCaseSensitiveSort(bool caseSensitiveSort)
     {
-        Qt::CaseSensitivity cs = caseSensitiveSort
-                ? Qt::CaseSensitive
-                : Qt::CaseInsensitive;
-
-        if (cs == sortCaseSensitivity())
+        if (caseSensitiveSort == m_caseSensitiveSort)
             return;
 
-        setSortCaseSensitivity(cs);
+        m_caseSensitiveSort = caseSensitiveSort;
+        scheduleUpdate(SortInvalidated);
         emit caseSensitiveSortChanged(caseSensitiveSort);
     }
 
     void setLocaleAwareSort(bool localeAwareSort)
     {
-        if (localeAwareSort == isSortLocaleAware())
+        if (localeAwareSort == m_localeAwareSort)
             return;
 
-        setSortLocaleAware(localeAwareSort);
+        m_localeAwareSort = localeAwareSort;
+        scheduleUpdate(SortInvalidated);
         emit localeAwareSortChanged(localeAwareSort);
     }
 
     void setDescendingSort(bool descendingSort)
     {
-        if (descendingSort == (sortOrder() == Qt::DescendingOrder))
+        if (descendingSort == m_descendingSort)
             return;
 
-        sort(0, descendingSort ? Qt::DescendingOrder : Qt::AscendingOrder);
+        m_descendingSort = descendingSort;
+        scheduleUpdate(SortInvalidated);
         emit descendingSortChanged(descendingSort);
     }
 
@@ -91,22 +107,56 @@ signals:
     void comparatorChanged(QJSValue comparator);
     void filterChanged(QJSValue filter);
     void modelChanged(JsonListModel* model);
+    void sourceChanged(Collection* source);
     void caseSensitiveSortChanged(bool caseSensitiveSort);
     void localeAwareSortChanged(bool localeAwareSort);
     void descendingSortChanged(bool descendingSort);
     void countChanged(int count);
+    void statsEnabledChanged();
+    void updateDelayChanged(int updateDelay);
 
 private slots:
     void emitCountChanged();
+    void sourceModelChanged();
+    void sortStarted();
+    void sortFinished();
 
 protected:
+    enum PendingUpdate {
+        SortRoleInvalidated = 0x1,
+        SortInvalidated = 0x2,
+        FilterInvalidated = 0x4
+    };
+
+    void scheduleUpdate(int updates);
+    void applySort(bool force);
+    void doSort();
     void updateModel();
+    void connectModel();
+    QJSValue sourceAt(int sourceRow) const;
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const;
     bool lessThan(const QModelIndex &source_left, const QModelIndex &source_right) const;
 
 private:
+    enum StatsCounter {
+        ComparatorCounter,
+        FilterCounter,
+        SortPassCounter,
+        ResetCounter,
+        StatsCounterCount
+    };
+
     mutable QJSValue m_comparator;
     mutable QJSValue m_filter;
+    mutable Stats m_stats;
+    QElapsedTimer m_sortTimer;
+    QPointer<JsonListModel> m_connectedModel;
+    QTimer m_updateTimer;
+    int m_pendingUpdates;
+    int m_updateDelay;
+    bool m_caseSensitiveSort;
+    bool m_localeAwareSort;
+    bool m_descendingSort;
 };
 
 } } }
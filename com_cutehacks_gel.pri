@@ -3,9 +3,11 @@ HEADERS += \
     $$PWD/jsvalueiterator.h \
     $$PWD/jsonlistmodel.h \
     $$PWD/collection.h \
+    $$PWD/stats.h \
     $$PWD/gel.h
 
 SOURCES += \
     $$PWD/jsonlistmodel.cpp \
     $$PWD/collection.cpp \
+    $$PWD/stats.cpp \
     $$PWD/gel.cpp
@@ -1,4 +1,5 @@
 #include <QDebug>
+#include <cmath>
 #include <QtCore/QReadWriteLock>
 #include <QtQml/qqml.h>
 #include <QtQml/QQmlEngine>
@@ -15,12 +16,45 @@ namespace com { namespace cutehacks { namespace gel {
 
 static const int BASE_ROLE = Qt::UserRole + 1;
 
+// Builds the same signature as JsonListModel::shapeOf(), but runs entirely
+// inside the JS engine so that no QString is created per property
+static const char SHAPE_FUNCTION[] =
+    "(function shape(o) {"
+    "    var s = '';"
+    "    var keys = Object.keys(o);"
+    "    for (var i = 0; i < keys.length; i++) {"
+    "        var k = keys[i];"
+    "        var v = o[k];"
+    "        s += k.length + ':' + k;"
+    "        if (v !== null && (typeof v === 'object' || typeof v === 'function')"
+    "                && !Array.isArray(v))"
+    "            s += '{' + shape(v) + '}';"
+    "    }"
+    "    return s;"
+    "})";
+
+static const char * const STATS_NAMES[] = {
+    "add",
+    "patch",
+    "roleExtraction",
+    "data",
+    "attachedProperty",
+    "reset",
+    "roleLookup"
+};
+
 JsonListModel::JsonListModel(QObject *parent) :
     QAbstractItemModel(parent),
     m_lock(new QReadWriteLock(QReadWriteLock::Recursive)),
+    m_idType(AutoId),
+    m_intIds(false),
     m_idAttribute("id"),
-    m_dynamicRoles(false)
+    m_dynamicRoles(false),
+    m_schemaInference(false),
+    m_stats(STATS_NAMES, StatsCounterCount),
+    m_roleCache(false)
 {
+    m_stats.setOwner(this);
     connect(this, SIGNAL(rowsRemoved(QModelIndex,int,int)),
             this, SLOT(emitCountChanged()));
     connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)),
@@ -40,6 +74,92 @@ void JsonListModel::setDynamicRoles(bool dynamicRoles)
     emit dynamicRolesChanged();
 }
 
+bool JsonListModel::schemaInference() const
+{
+    return m_schemaInference;
+}
+
+void JsonListModel::setSchemaInference(bool schemaInference)
+{
+    if (schemaInference == m_schemaInference)
+        return;
+    m_schemaInference = schemaInference;
+    m_shapes.clear();
+    emit schemaInferenceChanged();
+}
+
+bool JsonListModel::statsEnabled() const
+{
+    return m_stats.isEnabled();
+}
+
+void JsonListModel::setStatsEnabled(bool statsEnabled)
+{
+    if (statsEnabled == m_stats.isEnabled())
+        return;
+    m_stats.setEnabled(statsEnabled);
+    emit statsEnabledChanged();
+}
+
+QVariantMap JsonListModel::stats() const
+{
+    return m_stats.toVariantMap();
+}
+
+void JsonListModel::resetStats()
+{
+    m_stats.reset();
+}
+
+bool JsonListModel::roleCache() const
+{
+    return m_roleCache;
+}
+
+void JsonListModel::setRoleCache(bool roleCache)
+{
+    if (roleCache == m_roleCache)
+        return;
+    m_roleCache = roleCache;
+    clearCache();
+    emit roleCacheChanged();
+}
+
+void JsonListModel::cacheData(int row, int role, const QVariant &value) const
+{
+    if (!m_roleCache)
+        return;
+
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    QVector<QVariant> &column = m_cache[role];
+    if (column.count() <= row)
+        column.resize(keyCount());
+    column[row] = value;
+}
+
+void JsonListModel::invalidateCachedRow(int row, bool removed)
+{
+    if (!m_roleCache)
+        return;
+
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    QHash<int, QVector<QVariant> >::iterator column = m_cache.begin();
+    for (; column != m_cache.end(); ++column) {
+        if (row >= column->count())
+            continue;
+        if (removed)
+            column->remove(row);
+        else
+            (*column)[row] = QVariant();
+    }
+}
+
+void JsonListModel::clearCache()
+{
+    QMutexLocker cacheLocker(&m_cacheMutex);
+    m_cache.clear();
+}
+
 QJSValue JsonListModel::attachedProperties() const
 {
     return m_attachedProperties;
@@ -92,7 +212,7 @@ bool JsonListModel::extractRoles(const QJSValue &item,
             if (addRole(n))
                 rolesAdded = true;
             QJSValue v = it.value();
-            if (!v.isArray() && v.isObject() && extractRoles(it.value(), n + "."))
+            if (!v.isArray() && v.isObject() && extractRoles(v, n + "."))
                 rolesAdded = true;
         }
     }
@@ -100,72 +220,227 @@ bool JsonListModel::extractRoles(const QJSValue &item,
     return rolesAdded;
 }
 
+QString JsonListModel::shapeOf(const QJSValue &item) const
+{
+    // The signature lists the keys in order, each prefixed by its length,
+    // with the keys of nested objects enclosed in braces. Two objects have
+    // the same signature only if they produce the same roles.
+    if (m_shapeFunction.isUndefined()) {
+        if (QQmlEngine *engine = qmlEngine(this))
+            m_shapeFunction = engine->evaluate(SHAPE_FUNCTION);
+    }
+    if (m_shapeFunction.isCallable())
+        return m_shapeFunction.call(QJSValueList() << item).toString();
+
+    QString shape;
+    JSValueIterator it(item);
+    while (it.next()) {
+        QString name = it.name();
+        shape += QString::number(name.length()) + ':' + name;
+        QJSValue v = it.value();
+        if (!v.isArray() && v.isObject())
+            shape += '{' + shapeOf(v) + '}';
+    }
+    return shape;
+}
+
+bool JsonListModel::updateRoles(const QJSValue &item)
+{
+    if (m_schemaInference && !item.isArray() && item.isObject()) {
+        // only walk the roles of objects with a shape we have not seen before
+        QString shape = shapeOf(item);
+        if (m_shapes.contains(shape))
+            return false;
+        m_shapes.insert(shape);
+    }
+
+    StatsTimer timer(m_stats, RoleExtractionCounter);
+    return extractRoles(item);
+}
+
 void JsonListModel::emitCountChanged()
 {
     emit countChanged(rowCount());
 }
 
+void JsonListModel::emitRolesChanged()
+{
+    StatsTimer timer(m_stats, ResetCounter);
+
+    // this implies a model reset
+    clearCache();
+    emit rolesChanged();
+    beginResetModel();
+    endResetModel();
+    emitCountChanged();
+}
+
+bool JsonListModel::toIntId(const QString &id, qint64 *key)
+{
+    // only accept strings that are the canonical form of the number, so
+    // that "042" and "42" remain different ids
+    bool ok;
+    qint64 k = id.toLongLong(&ok);
+    if (!ok || QString::number(k) != id)
+        return false;
+    *key = k;
+    return true;
+}
+
+bool JsonListModel::toIntId(const QJSValue &id, qint64 *key)
+{
+    if (id.isNumber()) {
+        // integers larger than 2^53 can not be represented exactly
+        double d = id.toNumber();
+        if (d != std::floor(d) || qAbs(d) > 9007199254740992.0)
+            return false;
+        *key = qint64(d);
+        return true;
+    } else if (id.isString()) {
+        return toIntId(id.toString(), key);
+    }
+    return false;
+}
+
+void JsonListModel::convertToStringIds()
+{
+    if (!m_intIds)
+        return;
+
+    for (int i = 0; i < m_intKeys.count(); ++i) {
+        QHash<QString, int>::iterator it =
+                m_rows.insert(QString::number(m_intKeys.at(i)), i);
+        m_keys.append(it.key());
+    }
+    m_intKeys.clear();
+    m_intRows.clear();
+    m_intIds = false;
+}
+
+bool JsonListModel::convertToIntIds()
+{
+    if (m_intIds)
+        return true;
+
+    QVector<qint64> keys;
+    keys.reserve(m_keys.count());
+    foreach (const QString &id, m_keys) {
+        qint64 key;
+        if (!toIntId(id, &key))
+            return false;
+        keys.append(key);
+    }
+
+    for (int i = 0; i < keys.count(); ++i)
+        m_intRows.insert(keys.at(i), i);
+    m_intKeys = keys;
+    m_keys.clear();
+    m_rows.clear();
+    m_intIds = true;
+    return true;
+}
+
+QJSValue JsonListModel::itemAt(int row) const
+{
+    return m_items.at(row);
+}
+
+int JsonListModel::rowOf(const QJSValue &id) const
+{
+    if (m_intIds) {
+        qint64 key;
+        if (!toIntId(id, &key))
+            return -1;
+        return m_intRows.value(key, -1);
+    }
+    return m_rows.value(id.toString(), -1);
+}
+
 int JsonListModel::addItem(const QJSValue &item)
 {
     int row = -1;
 
-    QString id;
+    QJSValue id;
     if (item.isString() || item.isNumber() || item.isDate()) {
-        id = item.toString();
+        id = item;
     } else if (item.isObject()) {
-        QJSValue p = item.property(m_idAttribute);
-        if (p.isUndefined()) {
+        id = item.property(m_idAttribute);
+        if (id.isUndefined()) {
             qWarning("Object does not have a %s property", qPrintable(m_idAttribute));
             return row;
         }
-        id = p.toString();
+    } else {
+        return row;
     }
 
-    QJSValue existingItem = m_items[id];
+    qint64 intKey = 0;
+    if (keyCount() == 0 && m_idType != StringId)
+        m_intIds = m_idType == IntId || id.isNumber();
 
-    m_items[id] = item;
-    if (existingItem.isUndefined()) {
-        m_keys.append(id);
-        row = m_keys.count() - 1;
-        return row;
+    if (m_intIds && !toIntId(id, &intKey)) {
+        if (m_idType == IntId)
+            qWarning("Id %s is not an integer, using string ids", qPrintable(id.toString()));
+        convertToStringIds();
     }
 
-    return m_keys.indexOf(id);
+    if (m_intIds) {
+        QHash<qint64, int>::const_iterator it = m_intRows.constFind(intKey);
+        if (it == m_intRows.constEnd()) {
+            m_intRows.insert(intKey, m_items.count());
+            m_intKeys.append(intKey);
+            m_items.append(item);
+            return m_items.count() - 1;
+        }
+        row = it.value();
+    } else {
+        QString key = id.toString();
+        QHash<QString, int>::const_iterator it = m_rows.constFind(key);
+        if (it == m_rows.constEnd()) {
+            // append the key stored in the hash so that both share the same
+            // string data instead of holding a copy each
+            QHash<QString, int>::iterator inserted = m_rows.insert(key, m_items.count());
+            m_keys.append(inserted.key());
+            m_items.append(item);
+            return m_items.count() - 1;
+        }
+        row = it.value();
+    }
+
+    m_items[row] = item;
+    invalidateCachedRow(row);
+    return row;
 }
 
 void JsonListModel::add(const QJSValue &item)
 {
+    StatsTimer timer(m_stats, AddCounter);
+
     m_lock->lockForWrite();
-    int originalSize = m_keys.count();
+    int originalSize = keyCount();
     if (item.isArray()) {
-        JSValueIterator array(item);
         int updateFrom = INT_MAX;
         int updateTo = INT_MIN;
 
+        // index the array directly rather than iterating over its property
+        // names, this avoids creating a string key for every element
         bool rolesAdded = false;
-        bool isFirstItem = true;
-        while (array.next()) {
-            if (!array.hasNext())
-                break; // last value in array is an int with the length
-            if ((m_dynamicRoles || isFirstItem) && extractRoles(array.value()))
+        quint32 length = item.property("length").toUInt();
+        for (quint32 i = 0; i < length; ++i) {
+            QJSValue value = item.property(i);
+            if ((m_dynamicRoles || i == 0) && updateRoles(value))
                 rolesAdded = true;
-            int row = addItem(array.value());
+            int row = addItem(value);
             if (row >= 0 && row < originalSize) {
                 updateFrom = qMin(updateFrom, row);
                 updateTo = qMax(updateTo, row);
             }
-            isFirstItem = false;
         }
 
         if (rolesAdded) {
-            // this implies a model reset
             m_lock->unlock();
-            emit rolesChanged();
-            beginResetModel();
-            endResetModel();
-            emitCountChanged();
+            emitRolesChanged();
         } else {
-            int newSize = m_keys.count();
+            int newSize = keyCount();
             m_lock->unlock();
 
             // emit signals after the mutex is unlocked
@@ -179,16 +454,12 @@ void JsonListModel::add(const QJSValue &item)
             }
         }
     } else {
-        bool rolesAdded = extractRoles(item);
+        bool rolesAdded = updateRoles(item);
         int row = addItem(item);
 
         if (rolesAdded) {
-            // this implies a model reset
             m_lock->unlock();
-            emit rolesChanged();
-            beginResetModel();
-            endResetModel();
-            emitCountChanged();
+            emitRolesChanged();
             return;
         }
 
@@ -200,7 +471,7 @@ void JsonListModel::add(const QJSValue &item)
             return;
         }
 
-        int newSize = m_keys.count();
+        int newSize = keyCount();
         m_lock->unlock();
 
         if (newSize > originalSize) {
@@ -210,28 +481,197 @@ void JsonListModel::add(const QJSValue &item)
     }
 }
 
+void JsonListModel::touchRoles(const QString &path, QSet<int> *roles) const
+{
+    // the role itself and all roles nested inside it
+    QString nested = path + ".";
+    for (int i = 0; i < m_roles.count(); ++i) {
+        const QString &role = m_roles.at(i);
+        if (role == path || role.startsWith(nested))
+            roles->insert(BASE_ROLE + i);
+    }
+}
+
+void JsonListModel::merge(QJSValue target, const QJSValue &delta, const QString &prefix,
+                          QSet<int> *roles, bool *rolesAdded, bool extract)
+{
+    JSValueIterator it(delta);
+    while (it.next()) {
+        QString name = it.name();
+        if (prefix.isEmpty() && name == m_idAttribute)
+            continue;
+        mergeProperty(target, name, it.value(), prefix, roles, rolesAdded, extract);
+    }
+}
+
+void JsonListModel::mergeProperty(QJSValue target, const QString &name, const QJSValue &value,
+                                  const QString &prefix, QSet<int> *roles,
+                                  bool *rolesAdded, bool extract)
+{
+    // A dotted key such as "owner.name" addresses the nested property, the
+    // same way as the role names do
+    int dot = name.indexOf('.');
+    if (dot >= 0) {
+        QString head = name.left(dot);
+        QString path = prefix + head;
+        QJSValue nested = target.property(head);
+        if (nested.isArray() || !nested.isObject()) {
+            qWarning("Unable to patch %s, %s is not an object",
+                     qPrintable(prefix + name), qPrintable(path));
+            return;
+        }
+        int role = m_roles.indexOf(path);
+        if (role >= 0)
+            roles->insert(BASE_ROLE + role);
+        mergeProperty(nested, name.mid(dot + 1), value, path + ".",
+                      roles, rolesAdded, extract);
+        return;
+    }
+
+    QString path = prefix + name;
+    QJSValue current = target.property(name);
+
+    if (extract && addRole(path))
+        *rolesAdded = true;
+
+    if (!value.isArray() && value.isObject()
+            && !current.isArray() && current.isObject()) {
+        int role = m_roles.indexOf(path);
+        if (role >= 0)
+            roles->insert(BASE_ROLE + role);
+        merge(current, value, path + ".", roles, rolesAdded, extract);
+    } else {
+        target.setProperty(name, value);
+        if (extract && !value.isArray() && value.isObject()
+                && extractRoles(value, path + "."))
+            *rolesAdded = true;
+        touchRoles(path, roles);
+    }
+}
+
+int JsonListModel::patchItem(const QJSValue &delta, QSet<int> *roles,
+                             bool *rolesAdded, bool extract)
+{
+    bool isObject = !delta.isArray() && delta.isObject();
+    QJSValue id = delta;
+    if (isObject) {
+        id = delta.property(m_idAttribute);
+        if (id.isUndefined()) {
+            qWarning("Object does not have a %s property", qPrintable(m_idAttribute));
+            return -1;
+        }
+    }
+
+    int row = rowOf(id);
+    QJSValue item = row >= 0 ? itemAt(row) : QJSValue();
+    if (!isObject || item.isArray() || !item.isObject()) {
+        // nothing to merge with, so just store the delta as is
+        if (extract && updateRoles(delta))
+            *rolesAdded = true;
+        if (row >= 0) {
+            for (int i = 0; i < m_roles.count(); ++i)
+                roles->insert(BASE_ROLE + i);
+        }
+        return addItem(delta);
+    }
+
+    merge(item, delta, QString(), roles, rolesAdded, extract);
+    invalidateCachedRow(row);
+    return row;
+}
+
+void JsonListModel::patch(const QJSValue &item)
+{
+    StatsTimer timer(m_stats, PatchCounter);
+
+    m_lock->lockForWrite();
+    int originalSize = keyCount();
+    int updateFrom = INT_MAX;
+    int updateTo = INT_MIN;
+    bool rolesAdded = false;
+    QSet<int> roles;
+
+    if (item.isArray()) {
+        quint32 length = item.property("length").toUInt();
+        for (quint32 i = 0; i < length; ++i) {
+            int row = patchItem(item.property(i), &roles, &rolesAdded,
+                                m_dynamicRoles || i == 0);
+            if (row >= 0 && row < originalSize) {
+                updateFrom = qMin(updateFrom, row);
+                updateTo = qMax(updateTo, row);
+            }
+        }
+    } else {
+        int row = patchItem(item, &roles, &rolesAdded, true);
+        if (row >= 0 && row < originalSize)
+            updateFrom = updateTo = row;
+    }
+
+    if (rolesAdded) {
+        m_lock->unlock();
+        emitRolesChanged();
+        return;
+    }
+
+    // attached properties are computed from the item, so they might have
+    // changed as well
+    if (!roles.isEmpty()) {
+        JSValueIterator it(m_attachedProperties);
+        while (it.next()) {
+            int role = m_roles.indexOf(it.name());
+            if (role >= 0)
+                roles.insert(BASE_ROLE + role);
+        }
+    }
+
+    int newSize = keyCount();
+    m_lock->unlock();
+
+    // emit signals after the mutex is unlocked
+    if (newSize > originalSize) {
+        beginInsertRows(QModelIndex(), originalSize, newSize - 1);
+        endInsertRows();
+    }
+    if (updateFrom != INT_MAX && !roles.isEmpty()) {
+        emit dataChanged(createIndex(updateFrom, 0), createIndex(updateTo, 0),
+                         roles.toList().toVector());
+    }
+}
+
 void JsonListModel::remove(const QJSValue &item)
 {
     int index;
     {
-        QString key;
+        QJSValue id;
         if (item.isString() || item.isNumber() || item.isDate()) {
-            key = item.toString();
+            id = item;
         } else if (item.hasProperty(m_idAttribute)){
-            key = item.property(m_idAttribute).toString();
+            id = item.property(m_idAttribute);
         } else {
             qWarning("Unable to remove item");
             return;
         }
 
         QWriteLocker writeLocker(m_lock);
-        index = m_keys.indexOf(key);
+        index = rowOf(id);
 
         if (index == -1)
             return;
 
-        m_keys.removeAt(index);
-        m_items.remove(key);
+        invalidateCachedRow(index, true);
+        // the rows after the removed one move up by one
+        m_items.remove(index);
+        if (m_intIds) {
+            m_intRows.remove(m_intKeys.at(index));
+            m_intKeys.remove(index);
+            for (int i = index; i < m_intKeys.count(); ++i)
+                m_intRows[m_intKeys.at(i)] = i;
+        } else {
+            m_rows.remove(m_keys.at(index));
+            m_keys.removeAt(index);
+            for (int i = index; i < m_keys.count(); ++i)
+                m_rows[m_keys.at(i)] = i;
+        }
     }
     beginRemoveRows(QModelIndex(), index, index);
     endRemoveRows();
@@ -240,9 +680,14 @@ void JsonListModel::remove(const QJSValue &item)
 void JsonListModel::clear()
 {
     m_lock->lockForWrite();
-    int originalSize = m_keys.length();
-    m_keys.clear();
+    int originalSize = keyCount();
     m_items.clear();
+    m_keys.clear();
+    m_rows.clear();
+    m_intKeys.clear();
+    m_intRows.clear();
+    m_intIds = false;
+    clearCache();
     m_lock->unlock();
 
    beginRemoveRows(QModelIndex(), 0, originalSize);
@@ -252,32 +697,33 @@ void JsonListModel::clear()
 QJSValue JsonListModel::at(int row) const
 {
     QReadLocker locker(m_lock);
-    if (row >= 0 && row < m_keys.count()) {
-        return m_items[m_keys[row]];
+    if (row >= 0 && row < keyCount()) {
+        return itemAt(row);
     }
     return QJSValue();
 }
 
 QJSValue JsonListModel::get(const QJSValue &id) const
 {
-    QString key = id.toString();
     QReadLocker readLock(m_lock);
-    return m_items[key];
+    int row = rowOf(id);
+    if (row < 0)
+        return QJSValue();
+    return m_items.at(row);
 }
 
 QJSValue JsonListModel::asArray(bool deepCopy) const
 {
     QQmlEngine *engine = qmlEngine(this);
     QReadLocker readLock(m_lock);
-    QJSValue array = engine->newArray(m_keys.length());
-    QList<QString>::const_iterator it = m_keys.cbegin();
-    int i = 0;
+    int count = keyCount();
+    QJSValue array = engine->newArray(count);
     if (deepCopy) {
-        while (it != m_keys.cend())
-            array.setProperty(i++, clone(engine, m_items.value(*it++)));
+        for (int i = 0; i < count; ++i)
+            array.setProperty(i, clone(engine, itemAt(i)));
     } else {
-        while (it != m_keys.cend())
-            array.setProperty(i++, m_items.value(*it++));
+        for (int i = 0; i < count; ++i)
+            array.setProperty(i, itemAt(i));
     }
     return array;
 }
@@ -285,7 +731,7 @@ QJSValue JsonListModel::asArray(bool deepCopy) const
 QModelIndex JsonListModel::index(int row, int column, const QModelIndex &) const
 {
     QReadLocker readLock(m_lock);
-    if (row >= 0 && row < m_keys.count()) {
+    if (row >= 0 && row < keyCount()) {
         return createIndex(row, column);
     } else {
         qWarning("Out of bounds");
@@ -301,7 +747,7 @@ QModelIndex JsonListModel::parent(const QModelIndex &) const
 int JsonListModel::rowCount(const QModelIndex &) const
 {
     QReadLocker locker(m_lock);
-    return m_keys.count();
+    return keyCount();
 }
 
 int JsonListModel::columnCount(const QModelIndex &) const
@@ -311,18 +757,30 @@ int JsonListModel::columnCount(const QModelIndex &) const
 
 QVariant JsonListModel::data(const QModelIndex &index, int role) const
 {
+    StatsTimer timer(m_stats, DataCounter);
     QReadLocker readLock(m_lock);
     int row = index.row();
-    if (row < 0 || row > m_keys.count()) {
+    if (row < 0 || row >= keyCount()) {
         qWarning("Out of bounds");
         return QVariant();
     }
 
-    QJSValue item = m_items[m_keys[row]];
+    if (m_roleCache) {
+        QMutexLocker cacheLocker(&m_cacheMutex);
+        QHash<int, QVector<QVariant> >::const_iterator column = m_cache.constFind(role);
+        if (column != m_cache.constEnd() && row < column->count() && column->at(row).isValid())
+            return column->at(row);
+    }
+
+    // everything below reads the value from the item itself
+    StatsTimer lookupTimer(m_stats, RoleLookupCounter);
+    QJSValue item = itemAt(row);
     QString roleName = getRole(role);
 
     if (item.isString() || item.isNumber() || item.isDate()) {
-        return item.toVariant();
+        QVariant value = item.toVariant();
+        cacheData(row, role, value);
+        return value;
     } else {
         QStringList parts = roleName.split(".");
         roleName = parts.takeLast();
@@ -330,13 +788,20 @@ QVariant JsonListModel::data(const QModelIndex &index, int role) const
             item = item.property(*p);
         }
         QJSValue prop = item.property(roleName);
-        if (!prop.isUndefined())
-            return prop.toVariant();
+        if (!prop.isUndefined()) {
+            QVariant value = prop.toVariant();
+            cacheData(row, role, value);
+            return value;
+        }
+        // attached properties are not cached since they may depend on
+        // state outside of the item
         prop = m_attachedProperties.property(roleName);
         if (!prop.isUndefined()) {
             QJSValue result = prop;
-            if (prop.isCallable())
+            if (prop.isCallable()) {
+                StatsTimer attachedTimer(m_stats, AttachedPropertyCounter);
                 result = prop.call(QJSValueList() << item << row);
+            }
             return result.toVariant();
         }
         return prop.toVariant();
@@ -373,6 +838,47 @@ int JsonListModel::getRole(const QString &role) const
     return BASE_ROLE + roleIndex;
 }
 
+QString JsonListModel::idType() const
+{
+    switch (m_idType) {
+    case StringId:
+        return "string";
+    case IntId:
+        return "int";
+    default:
+        return "auto";
+    }
+}
+
+void JsonListModel::setIdType(QString idType)
+{
+    IdType type;
+    if (idType == "auto") {
+        type = AutoId;
+    } else if (idType == "string") {
+        type = StringId;
+    } else if (idType == "int") {
+        type = IntId;
+    } else {
+        qWarning("Unknown id type %s", qPrintable(idType));
+        return;
+    }
+
+    if (type == m_idType)
+        return;
+
+    {
+        QWriteLocker writeLocker(m_lock);
+        m_idType = type;
+        if (type == StringId)
+            convertToStringIds();
+        else if (type == IntId && keyCount() > 0 && !convertToIntIds())
+            qWarning("Not all ids are integers, using string ids");
+    }
+
+    emit idTypeChanged(idType);
+}
+
 void JsonListModel::setIdAttribute(QString idAttribute)
 {
     if (m_idAttribute == idAttribute)
@@ -2,10 +2,14 @@
 #define JSONLISTMODEL_H
 
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
 #include <QtCore/QSet>
+#include <QtCore/QVector>
 #include <QtCore/QAbstractItemModel>
 #include <QtQml/QJSValue>
 
+#include "stats.h"
+
 class QReadWriteLock;
 class QQmlEngine;
 
@@ -16,19 +20,26 @@ class JsonListModel : public QAbstractItemModel
     Q_OBJECT
 
     Q_PROPERTY(QString idAttribute READ idAttribute WRITE setIdAttribute NOTIFY idAttributeChanged)
+    Q_PROPERTY(QString idType READ idType WRITE setIdType NOTIFY idTypeChanged)
     Q_PROPERTY(bool dynamicRoles READ dynamicRoles WRITE setDynamicRoles NOTIFY dynamicRolesChanged)
+    Q_PROPERTY(bool schemaInference READ schemaInference WRITE setSchemaInference NOTIFY schemaInferenceChanged)
     Q_PROPERTY(QJSValue attachedProperties READ attachedProperties WRITE setAttachedProperties NOTIFY attachedPropertiesChanged)
     Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool statsEnabled READ statsEnabled WRITE setStatsEnabled NOTIFY statsEnabledChanged)
+    Q_PROPERTY(bool roleCache READ roleCache WRITE setRoleCache NOTIFY roleCacheChanged)
 
 public:
     JsonListModel(QObject *parent = 0);
 
     Q_INVOKABLE void add(const QJSValue&);
+    Q_INVOKABLE void patch(const QJSValue&);
     Q_INVOKABLE void remove(const QJSValue&);
     Q_INVOKABLE void clear();
     Q_INVOKABLE QJSValue at(int) const;
     Q_INVOKABLE QJSValue get(const QJSValue&) const;
     Q_INVOKABLE QJSValue asArray(bool deepCopy = false) const;
+    Q_INVOKABLE QVariantMap stats() const;
+    Q_INVOKABLE void resetStats();
 
     QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
     QModelIndex parent(const QModelIndex &child) const;
@@ -38,20 +49,30 @@ public:
     bool setData(const QModelIndex &index, const QVariant &value, int role);
     QHash<int, QByteArray> roleNames() const;
     QString idAttribute() const;
-    int getRole(const QString&) const;
+    QString idType() const;
+    Q_INVOKABLE int getRole(const QString&) const;
     bool dynamicRoles() const;
     void setDynamicRoles(bool dynamicRoles);
+    bool schemaInference() const;
+    void setSchemaInference(bool schemaInference);
     QJSValue attachedProperties() const;
+    bool statsEnabled() const;
+    void setStatsEnabled(bool statsEnabled);
+    bool roleCache() const;
+    void setRoleCache(bool roleCache);
 
     inline int count() const { return rowCount(); }
 
 protected:
     int addItem(const QJSValue &item);
+    int patchItem(const QJSValue &delta, QSet<int> *roles, bool *rolesAdded, bool extract);
     QString getRole(int role) const;
     bool extractRoles(const QJSValue &item, const QString&);
+    bool updateRoles(const QJSValue &item);
 
 public slots:
     void setIdAttribute(QString idAttribute);
+    void setIdType(QString idType);
     void setAttachedProperties(QJSValue attachedProperties);
 
 private slots:
@@ -59,23 +80,73 @@ private slots:
 
 signals:
     void idAttributeChanged(QString idAttribute);
+    void idTypeChanged(QString idType);
     void rolesChanged();
     void dynamicRolesChanged();
+    void schemaInferenceChanged();
     void attachedPropertiesChanged(QJSValue attachedProperties);
     void countChanged(int count);
+    void statsEnabledChanged();
+    void roleCacheChanged();
 
 private:
+    enum StatsCounter {
+        AddCounter,
+        PatchCounter,
+        RoleExtractionCounter,
+        DataCounter,
+        AttachedPropertyCounter,
+        ResetCounter,
+        RoleLookupCounter,
+        StatsCounterCount
+    };
+
+    enum IdType {
+        AutoId,
+        StringId,
+        IntId
+    };
+
+    void emitRolesChanged();
+    static bool toIntId(const QString &id, qint64 *key);
+    static bool toIntId(const QJSValue &id, qint64 *key);
+    void convertToStringIds();
+    bool convertToIntIds();
+    inline int keyCount() const { return m_items.count(); }
+    QJSValue itemAt(int row) const;
+    void cacheData(int row, int role, const QVariant &value) const;
+    void invalidateCachedRow(int row, bool removed = false);
+    void clearCache();
+    int rowOf(const QJSValue &id) const;
     bool addRole(const QString &string);
     QJSValue clone(QQmlEngine *, const QJSValue&) const;
+    void merge(QJSValue target, const QJSValue &delta, const QString &prefix,
+               QSet<int> *roles, bool *rolesAdded, bool extract);
+    void mergeProperty(QJSValue target, const QString &name, const QJSValue &value,
+                       const QString &prefix, QSet<int> *roles, bool *rolesAdded, bool extract);
+    void touchRoles(const QString &path, QSet<int> *roles) const;
+    QString shapeOf(const QJSValue &item) const;
 
     mutable QReadWriteLock *m_lock;
-    QHash<QString, QJSValue> m_items;
+    QVector<QJSValue> m_items;
     QList<QString> m_keys;
+    QHash<QString, int> m_rows;
+    QVector<qint64> m_intKeys;
+    QHash<qint64, int> m_intRows;
+    IdType m_idType;
+    bool m_intIds;
     QSet<QString> m_roleSet;
     QList<QString> m_roles;
     QString m_idAttribute;
     bool m_dynamicRoles;
+    bool m_schemaInference;
+    QSet<QString> m_shapes;
+    mutable QJSValue m_shapeFunction;
     QJSValue m_attachedProperties;
+    mutable Stats m_stats;
+    bool m_roleCache;
+    mutable QMutex m_cacheMutex;
+    mutable QHash<int, QVector<QVariant> > m_cache;
 };
 
 } } }
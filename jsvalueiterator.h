@@ -1,42 +1,60 @@
+#ifndef JSVALUEITERATOR_H
+#define JSVALUEITERATOR_H
+
 #include <QtQml/QJSValue>
 
 namespace com { namespace cutehacks { namespace gel {
 
+// Fallback for QJSValueIterator on Qt < 5.6. Arrays are walked by index and
+// objects by a cursor into the array returned by Object.keys(), so iterating
+// does not build an intermediate list of names.
 class JSValueIterator
 {
 public:
     JSValueIterator(const QJSValue &value)
-        : m_value(value)
+        : m_value(value),
+          m_isArray(value.isArray()),
+          m_index(-1),
+          m_length(0)
     {
-        if (value.isArray()) {
-            int length = value.property("length").toInt();
-            for (int i = 0; i < length; ++i)
-                m_keys << QString::number(i);
-            m_keys << QString::number(length);
+        if (m_isArray) {
+            m_length = value.property("length").toInt();
         } else {
             QJSValue object = value.property("constructor");
             QJSValue keysMethod = object.property("keys");
 
             if (keysMethod.isCallable()) {
-                QJSValue ret = keysMethod.callWithInstance(object, QJSValueList() << value);
-                foreach (QVariant key, ret.toVariant().toList())
-                    m_keys << key.toString();
+                m_keys = keysMethod.callWithInstance(object, QJSValueList() << value);
+                m_length = m_keys.property("length").toInt();
             }
         }
     }
 
     bool next()
     {
-        if (m_keys.isEmpty())
+        if (!hasNext())
             return false;
-        m_currentName = m_keys.takeFirst();
-        m_currentValue = m_value.property(m_currentName);
+        ++m_index;
+        if (m_isArray) {
+            m_currentValue = m_value.property(quint32(m_index));
+        } else {
+            m_currentName = m_keys.property(quint32(m_index)).toString();
+            m_currentValue = m_value.property(m_currentName);
+        }
         return true;
     }
 
-    bool hasNext() { return !m_keys.isEmpty(); }
+    bool hasNext() const { return m_index + 1 < m_length; }
+
+    QString name() const
+    {
+        if (m_index < 0)
+            return QString();
+        if (m_isArray)
+            return QString::number(m_index);
+        return m_currentName;
+    }
 
-    QString name() const { return m_currentName; }
     QJSValue value() const { return m_currentValue; }
 
 private:
@@ -44,8 +62,12 @@ private:
     QJSValue m_currentValue;
 
     QJSValue m_value;
-    QList<QString> m_keys;
+    QJSValue m_keys;
+    bool m_isArray;
+    int m_index;
+    int m_length;
 };
 
 } } }
 
+#endif // JSVALUEITERATOR_H
@@ -0,0 +1,65 @@
+// Copyright 2016 Cutehacks AS. All rights reserved.
+// License can be found in the LICENSE file.
+
+#include <QtCore/QObject>
+#include "stats.h"
+
+namespace com { namespace cutehacks { namespace gel {
+
+Q_LOGGING_CATEGORY(lcTrace, "com.cutehacks.gel.trace", QtWarningMsg)
+
+Stats::Stats(const char * const *names, int count) :
+    m_names(names),
+    m_counters(count),
+    m_owner(0),
+    m_enabled(false)
+{
+}
+
+void Stats::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+void Stats::setOwner(const QObject *owner)
+{
+    m_owner = owner;
+}
+
+void Stats::record(int counter, qint64 nsecs)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        Counter &c = m_counters[counter];
+        c.calls++;
+        c.nsecs += nsecs;
+    }
+
+    qCDebug(lcTrace, "%s %s %s %lld",
+            m_owner ? m_owner->metaObject()->className() : "",
+            m_owner ? qPrintable(m_owner->objectName()) : "",
+            m_names[counter],
+            nsecs);
+}
+
+void Stats::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_counters.fill(Counter());
+}
+
+QVariantMap Stats::toVariantMap() const
+{
+    // {name: {calls: n, msecs: t}} for every counter
+    QMutexLocker locker(&m_mutex);
+    QVariantMap map;
+    for (int i = 0; i < m_counters.count(); ++i) {
+        QVariantMap counter;
+        counter.insert("calls", m_counters.at(i).calls);
+        counter.insert("msecs", m_counters.at(i).nsecs / 1000000.0);
+        map.insert(m_names[i], counter);
+    }
+    return map;
+}
+
+} } }
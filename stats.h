@@ -0,0 +1,73 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+
+class QObject;
+
+namespace com { namespace cutehacks { namespace gel {
+
+Q_DECLARE_LOGGING_CATEGORY(lcTrace)
+
+// Call counts and accumulated time for a fixed set of named operations.
+// Recording only happens while the stats are enabled. Counters may be
+// updated from several threads at once, e.g. by concurrent data() calls.
+class Stats
+{
+public:
+    Stats(const char * const *names, int count);
+
+    inline bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+
+    void record(int counter, qint64 nsecs);
+    void reset();
+
+    void setOwner(const QObject *owner);
+    QVariantMap toVariantMap() const;
+
+private:
+    struct Counter {
+        Counter() : calls(0), nsecs(0) {}
+        quint64 calls;
+        qint64 nsecs;
+    };
+
+    const char * const *m_names;
+    mutable QMutex m_mutex;
+    QVector<Counter> m_counters;
+    const QObject *m_owner;
+    bool m_enabled;
+};
+
+// Times the enclosing scope and records it in a Stats counter
+class StatsTimer
+{
+public:
+    StatsTimer(Stats &stats, int counter)
+        : m_stats(stats.isEnabled() ? &stats : 0),
+          m_counter(counter)
+    {
+        if (m_stats)
+            m_timer.start();
+    }
+
+    ~StatsTimer()
+    {
+        if (m_stats)
+            m_stats->record(m_counter, m_timer.nsecsElapsed());
+    }
+
+private:
+    Stats *m_stats;
+    int m_counter;
+    QElapsedTimer m_timer;
+};
+
+} } }
+
+#endif // STATS_H
@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_bench
+QT += testlib qml
+CONFIG += warn_on testcase
+SOURCES += tst_bench.cpp
+
+include($$PWD/../../../com_cutehacks_gel.pri)
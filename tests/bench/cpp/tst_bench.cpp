@@ -0,0 +1,434 @@
+// Copyright 2016 Cutehacks AS. All rights reserved.
+// License can be found in the LICENSE file.
+
+#include <QtTest/QtTest>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlContext>
+
+#include "../../../gel.h"
+
+using namespace com::cutehacks::gel;
+
+class tst_Bench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void add_data();
+    void add();
+    void upsert_data();
+    void upsert();
+    void remove_data();
+    void remove();
+    void data_data();
+    void data();
+    void sortByRole_data();
+    void sortByRole();
+    void sortByComparator_data();
+    void sortByComparator();
+    void filter_data();
+    void filter();
+    void asArrayDeepCopy_data();
+    void asArrayDeepCopy();
+    void resetOnNewRoles();
+    void dynamicRoles_data();
+    void dynamicRoles();
+    void sharedViews_data();
+    void sharedViews();
+    void sharedViewsLookups_data();
+    void sharedViewsLookups();
+    void sharedReads_data();
+    void sharedReads();
+
+private:
+    void sizes();
+    QJSValue arrayData(int length, const QString &prefix = "foo");
+    void setup(JsonListModel *model);
+    void setResult(qint64 nsecs, int iterations);
+
+    QQmlEngine m_engine;
+};
+
+void tst_Bench::sizes()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("1k") << 1000;
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+QJSValue tst_Bench::arrayData(int length, const QString &prefix)
+{
+    QJSValue array = m_engine.newArray(length);
+    for (int i = 0; i < length; ++i) {
+        QJSValue item = m_engine.newObject();
+        item.setProperty("id", i);
+        // reverse the order so that sorting has some work to do
+        item.setProperty("value", prefix + QString::number(length - i));
+        item.setProperty("index", i);
+        array.setProperty(quint32(i), item);
+    }
+    return array;
+}
+
+void tst_Bench::setup(JsonListModel *model)
+{
+    // asArray() and friends need to find the engine through the object
+    QQmlEngine::setContextForObject(model, m_engine.rootContext());
+}
+
+// Benchmarks that need untimed work between iterations run a fixed number of
+// iterations themselves and report the average time of the timed part only.
+void tst_Bench::setResult(qint64 nsecs, int iterations)
+{
+    QTest::setBenchmarkResult(nsecs / 1000000.0 / iterations,
+                              QTest::WalltimeMilliseconds);
+}
+
+void tst_Bench::add_data() { sizes(); }
+
+void tst_Bench::add()
+{
+    // Adds to an empty model; clearing it again is not measured
+    QFETCH(int, size);
+    JsonListModel model;
+    setup(&model);
+    QJSValue array = arrayData(size);
+
+    const int iterations = 10;
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    for (int i = 0; i < iterations; ++i) {
+        model.clear();
+        timer.start();
+        model.add(array);
+        nsecs += timer.nsecsElapsed();
+    }
+    setResult(nsecs, iterations);
+    QCOMPARE(model.count(), size);
+}
+
+void tst_Bench::upsert_data() { sizes(); }
+
+void tst_Bench::upsert()
+{
+    QFETCH(int, size);
+    JsonListModel model;
+    setup(&model);
+    model.add(arrayData(size));
+    QJSValue updates = arrayData(size, "bar");
+
+    QBENCHMARK {
+        model.add(updates);
+    }
+    QCOMPARE(model.count(), size);
+}
+
+void tst_Bench::remove_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("front");
+    QTest::newRow("1k, front") << 1000 << true;
+    QTest::newRow("1k, middle") << 1000 << false;
+    QTest::newRow("10k, front") << 10000 << true;
+    QTest::newRow("10k, middle") << 10000 << false;
+    QTest::newRow("100k, front") << 100000 << true;
+    QTest::newRow("100k, middle") << 100000 << false;
+}
+
+void tst_Bench::remove()
+{
+    // Removes the first item or an item in the middle of the model. Every
+    // later row has its index entry rewritten, so removing at the front is
+    // the worst case. The item is added back at the end outside of the
+    // measurement so the model keeps its size.
+    QFETCH(int, size);
+    QFETCH(bool, front);
+    JsonListModel model;
+    setup(&model);
+    model.add(arrayData(size));
+    int row = front ? 0 : size / 2;
+
+    const int iterations = 100;
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    for (int i = 0; i < iterations; ++i) {
+        QJSValue item = model.at(row);
+        QJSValue id = item.property("id");
+        timer.start();
+        model.remove(id);
+        nsecs += timer.nsecsElapsed();
+        model.add(item);
+    }
+    setResult(nsecs, iterations);
+    QCOMPARE(model.count(), size);
+}
+
+void tst_Bench::data_data() { sizes(); }
+
+void tst_Bench::data()
+{
+    QFETCH(int, size);
+    JsonListModel model;
+    setup(&model);
+    model.add(arrayData(size));
+    QList<int> roles = model.roleNames().keys();
+
+    QBENCHMARK {
+        for (int row = 0; row < size; ++row) {
+            QModelIndex index = model.index(row, 0);
+            foreach (int role, roles)
+                model.data(index, role);
+        }
+    }
+}
+
+void tst_Bench::sortByRole_data() { sizes(); }
+
+void tst_Bench::sortByRole()
+{
+    QFETCH(int, size);
+    JsonListModel model;
+    setup(&model);
+    model.add(arrayData(size));
+    Collection collection;
+    collection.setModel(&model);
+    collection.setComparator(QJSValue("value"));
+
+    QBENCHMARK {
+        collection.reSort();
+    }
+    QCOMPARE(collection.count(), size);
+}
+
+void tst_Bench::sortByComparator_data() { sizes(); }
+
+void tst_Bench::sortByComparator()
+{
+    QFETCH(int, size);
+    JsonListModel model;
+    setup(&model);
+    model.add(arrayData(size));
+    Collection collection;
+    collection.setModel(&model);
+    collection.setComparator(m_engine.evaluate(
+        "(function(a, b) { return a.value < b.value; })"));
+
+    QBENCHMARK {
+        collection.reSort();
+    }
+    QCOMPARE(collection.count(), size);
+}
+
+void tst_Bench::filter_data() { sizes(); }
+
+void tst_Bench::filter()
+{
+    QFETCH(int, size);
+    JsonListModel model;
+    setup(&model);
+    model.add(arrayData(size));
+    Collection collection;
+    collection.setModel(&model);
+    collection.setFilter(m_engine.evaluate(
+        "(function(item, index) { return item.index % 2 == 0; })"));
+
+    QBENCHMARK {
+        collection.reFilter();
+    }
+    QCOMPARE(collection.count(), (size + 1) / 2);
+}
+
+void tst_Bench::asArrayDeepCopy_data() { sizes(); }
+
+void tst_Bench::asArrayDeepCopy()
+{
+    QFETCH(int, size);
+    JsonListModel model;
+    setup(&model);
+    model.add(arrayData(size));
+
+    QJSValue array;
+    QBENCHMARK {
+        array = model.asArray(true);
+    }
+    QCOMPARE(array.property("length").toInt(), size);
+}
+
+void tst_Bench::resetOnNewRoles()
+{
+    // Adds an item with one unknown property to a fresh model of 1000 items
+    // with a sorted collection, causing the roles to change and the model to
+    // be reset. Every iteration starts from the same three roles.
+    QJSValue array = arrayData(1000);
+    QJSValue item = m_engine.newObject();
+    item.setProperty("id", 0);
+    item.setProperty("value", "foo");
+    item.setProperty("extra", 1);
+
+    const int iterations = 20;
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    for (int i = 0; i < iterations; ++i) {
+        JsonListModel model;
+        setup(&model);
+        model.add(array);
+        Collection collection;
+        collection.setModel(&model);
+        collection.setComparator(QJSValue("value"));
+
+        timer.start();
+        model.add(item);
+        nsecs += timer.nsecsElapsed();
+        QCOMPARE(model.roleNames().count(), 4);
+    }
+    setResult(nsecs, iterations);
+}
+
+void tst_Bench::dynamicRoles_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("schemaInference");
+    QTest::newRow("10k") << 10000 << false;
+    QTest::newRow("10k, schemaInference") << 10000 << true;
+    QTest::newRow("100k") << 100000 << false;
+    QTest::newRow("100k, schemaInference") << 100000 << true;
+}
+
+void tst_Bench::dynamicRoles()
+{
+    // Adds an array of objects sharing the same shape with dynamicRoles to an
+    // empty model, so that the roles of every element are considered
+    QFETCH(int, size);
+    QFETCH(bool, schemaInference);
+    JsonListModel model;
+    setup(&model);
+    model.setDynamicRoles(true);
+    model.setSchemaInference(schemaInference);
+    QJSValue array = arrayData(size);
+
+    const int iterations = 10;
+    QElapsedTimer timer;
+    qint64 nsecs = 0;
+    for (int i = 0; i < iterations; ++i) {
+        model.clear();
+        timer.start();
+        model.add(array);
+        nsecs += timer.nsecsElapsed();
+    }
+    setResult(nsecs, iterations);
+    QCOMPARE(model.count(), size);
+}
+
+void tst_Bench::sharedViews_data()
+{
+    QTest::addColumn<int>("views");
+    QTest::addColumn<bool>("roleCache");
+    for (int views = 1; views <= 6; views++) {
+        QTest::newRow(qPrintable(QString("%1 views").arg(views))) << views << false;
+        QTest::newRow(qPrintable(QString("%1 views, cached").arg(views))) << views << true;
+    }
+}
+
+void tst_Bench::sharedViews()
+{
+    // Upserts every item of a model that is sorted by several collections.
+    // Every collection sorts on its own, so the total time grows with the
+    // number of views even with the role cache enabled.
+    QFETCH(int, views);
+    QFETCH(bool, roleCache);
+    JsonListModel model;
+    setup(&model);
+    model.setRoleCache(roleCache);
+    model.add(arrayData(10000));
+
+    QList<Collection*> collections;
+    for (int i = 0; i < views; ++i) {
+        Collection *collection = new Collection(&model);
+        collection->setModel(&model);
+        collection->setComparator(QJSValue("value"));
+        collection->setDescendingSort(i % 2);
+        collections << collection;
+    }
+
+    QJSValue updates = arrayData(10000, "bar");
+    QBENCHMARK {
+        model.add(updates);
+    }
+    QCOMPARE(collections.last()->count(), 10000);
+}
+
+void tst_Bench::sharedViewsLookups_data()
+{
+    sharedViews_data();
+}
+
+void tst_Bench::sharedViewsLookups()
+{
+    // Same setup as sharedViews(), but reports the roleLookup counter of the
+    // model, i.e. how many role values had to be read from the JSON objects
+    // for one upsert of every item, summed over all views. Without the role
+    // cache this grows with the number of views, with the cache it stays at
+    // one read per changed row. The sort work of each view is not included.
+    QFETCH(int, views);
+    QFETCH(bool, roleCache);
+    JsonListModel model;
+    setup(&model);
+    model.setRoleCache(roleCache);
+    model.add(arrayData(10000));
+
+    for (int i = 0; i < views; ++i) {
+        Collection *collection = new Collection(&model);
+        collection->setModel(&model);
+        collection->setComparator(QJSValue("value"));
+        collection->setDescendingSort(i % 2);
+    }
+
+    model.setStatsEnabled(true);
+    model.add(arrayData(10000, "bar"));
+    QVariantMap lookups = model.stats().value("roleLookup").toMap();
+    QTest::setBenchmarkResult(lookups.value("calls").toReal(), QTest::Events);
+}
+
+void tst_Bench::sharedReads_data()
+{
+    sharedViews_data();
+}
+
+void tst_Bench::sharedReads()
+{
+    // Upserts every item of a model shown by several collections that don't
+    // sort, each of which then reads the value of every row as the delegates
+    // of a view would. With the role cache enabled the views share the
+    // lookups.
+    QFETCH(int, views);
+    QFETCH(bool, roleCache);
+    JsonListModel model;
+    setup(&model);
+    model.setRoleCache(roleCache);
+    model.add(arrayData(10000));
+    int role = model.getRole("value");
+
+    QList<Collection*> collections;
+    for (int i = 0; i < views; ++i) {
+        Collection *collection = new Collection(&model);
+        collection->setModel(&model);
+        // don't re-sort on dataChanged, the views only read
+        collection->setDynamicSortFilter(false);
+        collections << collection;
+    }
+
+    QJSValue updates = arrayData(10000, "bar");
+    QBENCHMARK {
+        model.add(updates);
+        foreach (Collection *collection, collections) {
+            for (int row = 0; row < 10000; ++row)
+                collection->data(collection->index(row, 0), role);
+        }
+    }
+    QCOMPARE(collections.last()->count(), 10000);
+}
+
+QTEST_MAIN(tst_Bench)
+
+#include "tst_bench.moc"
@@ -0,0 +1,8 @@
+TEMPLATE = app
+TARGET = tst_qmlbench
+CONFIG += warn_on qmltestcase
+SOURCES += tst_qmlbench.cpp
+DEFINES += QUICK_TEST_SOURCE_DIR=\\\"$$PWD\\\"
+OTHER_FILES += *.qml
+
+include($$PWD/../../../com_cutehacks_gel.pri)
@@ -0,0 +1,133 @@
+// Copyright 2016 Cutehacks AS. All rights reserved.
+// License can be found in the LICENSE file.
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import com.cutehacks.gel 1.0
+
+TestCase {
+    name: "JsonListModelBenchmark"
+
+    // The body of a benchmark function is run repeatedly, so every model
+    // used below is filled once in initTestCase(). A body that has to undo
+    // its own work to keep the workload fixed says so in its name.
+
+    JsonListModel {
+        id: addModel
+    }
+
+    JsonListModel {
+        id: upsertModel
+    }
+
+    JsonListModel {
+        id: removeModel
+    }
+
+    JsonListModel {
+        id: resetModel
+    }
+
+    Collection {
+        id: resetSorted
+        model: resetModel
+        comparator: "value"
+    }
+
+    JsonListModel {
+        id: sortModel
+    }
+
+    Collection {
+        id: roleSorted
+        model: sortModel
+        comparator: "value"
+    }
+
+    Collection {
+        id: functionSorted
+        model: sortModel
+        comparator: function(a, b) { return a.value < b.value; }
+    }
+
+    Collection {
+        id: filtered
+        model: sortModel
+        filter: function(item) { return item.index % 2 == 0; }
+    }
+
+    property var data1k
+    property var data10k
+    property var data100k
+    property var updates10k
+
+    function arrayData(len, prefix) {
+        var a = [];
+        for (var i = 0; i < len; i++) {
+            a.push({id: i, value: prefix + (len - i), index: i});
+        }
+        return a;
+    }
+
+    function initTestCase() {
+        data1k = arrayData(1000, "foo");
+        data10k = arrayData(10000, "foo");
+        data100k = arrayData(100000, "foo");
+        updates10k = arrayData(10000, "bar");
+
+        upsertModel.add(data10k);
+        removeModel.add(data10k);
+        resetModel.add(data1k);
+        sortModel.add(data10k);
+    }
+
+    // add() on a filled model would measure upserts, so the model is
+    // cleared first as part of the measurement
+    function benchmark_clear_and_add_1k() {
+        addModel.clear();
+        addModel.add(data1k);
+    }
+
+    function benchmark_clear_and_add_10k() {
+        addModel.clear();
+        addModel.add(data10k);
+    }
+
+    function benchmark_clear_and_add_100k() {
+        addModel.clear();
+        addModel.add(data100k);
+    }
+
+    function benchmark_upsert_10k() {
+        upsertModel.add(updates10k);
+    }
+
+    // the item is added back so the model keeps its size
+    function benchmark_remove_and_readd_10k() {
+        removeModel.remove(5000);
+        removeModel.add(data10k[5000]);
+    }
+
+    // adds one unknown property to the three roles of a sorted 1k model,
+    // resetting it; run once since a repetition would find the role known
+    function benchmark_once_reset_on_new_roles_1k() {
+        resetModel.add({id: 0, value: "foo", extra: 1});
+    }
+
+    function benchmark_sort_role_10k() {
+        roleSorted.reSort();
+    }
+
+    function benchmark_sort_comparator_10k() {
+        functionSorted.reSort();
+    }
+
+    function benchmark_filter_10k() {
+        filtered.reFilter();
+    }
+
+    function benchmark_as_array_deep_copy_10k() {
+        sortModel.asArray(true);
+    }
+}
@@ -0,0 +1,5 @@
+// Copyright 2016 Cutehacks AS. All rights reserved.
+// License can be found in the LICENSE file.
+
+#include <QtQuickTest/quicktest.h>
+QUICK_TEST_MAIN(qmlbench)
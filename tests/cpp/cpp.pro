@@ -0,0 +1,7 @@
+TEMPLATE = app
+TARGET = tst_jsonlistmodel
+QT += testlib qml
+CONFIG += warn_on testcase
+SOURCES += tst_jsonlistmodel.cpp
+
+include($$PWD/../../com_cutehacks_gel.pri)
@@ -0,0 +1,78 @@
+// Copyright 2016 Cutehacks AS. All rights reserved.
+// License can be found in the LICENSE file.
+
+#include <QtTest/QtTest>
+#include <QtQml/QQmlEngine>
+#include <QtQml/QQmlContext>
+
+#include "../../gel.h"
+
+using namespace com::cutehacks::gel;
+
+// The roles passed with dataChanged are a QVector<int>, which QML in Qt 5.4
+// can not read, so they are checked from C++.
+class tst_JsonListModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void patchRoles_data();
+    void patchRoles();
+};
+
+void tst_JsonListModel::initTestCase()
+{
+    qRegisterMetaType<QVector<int> >();
+}
+
+void tst_JsonListModel::patchRoles_data()
+{
+    QTest::addColumn<QString>("patch");
+    QTest::addColumn<bool>("attached");
+    QTest::addColumn<QStringList>("roles");
+
+    QTest::newRow("flat key")
+            << "({id: 1, status: 'done'})" << false
+            << (QStringList() << "status");
+    QTest::newRow("nested merge")
+            << "({id: 1, owner: {name: 'y'}})" << false
+            << (QStringList() << "owner" << "owner.name");
+    QTest::newRow("dotted key")
+            << "({id: 1, 'owner.name': 'y'})" << false
+            << (QStringList() << "owner" << "owner.name");
+    QTest::newRow("attached properties")
+            << "({id: 1, status: 'done'})" << true
+            << (QStringList() << "status" << "upper");
+}
+
+void tst_JsonListModel::patchRoles()
+{
+    QFETCH(QString, patch);
+    QFETCH(bool, attached);
+    QFETCH(QStringList, roles);
+
+    QQmlEngine engine;
+    JsonListModel model;
+    QQmlEngine::setContextForObject(&model, engine.rootContext());
+    if (attached) {
+        model.setAttachedProperties(engine.evaluate(
+            "({upper: function(item) { return item.value.toUpperCase(); }})"));
+    }
+    model.add(engine.evaluate(
+        "({id: 1, value: 'a', status: 'open', owner: {name: 'x', age: 1}})"));
+
+    QSignalSpy spy(&model, SIGNAL(dataChanged(QModelIndex,QModelIndex,QVector<int>)));
+    model.patch(engine.evaluate(patch));
+    QCOMPARE(spy.count(), 1);
+
+    QStringList names;
+    foreach (int role, spy.at(0).at(2).value<QVector<int> >())
+        names << QString::fromUtf8(model.roleNames().value(role));
+    names.sort();
+    QCOMPARE(names, roles);
+}
+
+QTEST_MAIN(tst_JsonListModel)
+
+#include "tst_jsonlistmodel.moc"
@@ -0,0 +1,163 @@
+// Copyright 2016 Cutehacks AS. All rights reserved.
+// License can be found in the LICENSE file.
+
+import QtQuick 2.3
+import QtTest 1.0
+
+import com.cutehacks.gel 1.0
+
+TestCase {
+    name: "Collection"
+
+    JsonListModel {
+        id: jsonModel
+    }
+
+    Collection {
+        id: collection
+        model: jsonModel
+    }
+
+    Collection {
+        id: chained
+        source: collection
+        comparator: "id"
+        descendingSort: true
+    }
+
+    function arrayData(len) {
+        var a = [];
+        for (var i = 0; i < len; i++) {
+            a.push({id: i, value: "foo" + i});
+        }
+        return a;
+    }
+
+    function init() {
+        collection.updateDelay = -1;
+        collection.comparator = undefined;
+        collection.filter = undefined;
+        collection.descendingSort = false;
+        collection.caseSensitiveSort = true;
+        jsonModel.roleCache = false;
+        jsonModel.clear();
+    }
+
+    function test_sort_role() {
+        jsonModel.add(arrayData(10));
+        collection.comparator = "id";
+        collection.descendingSort = true;
+
+        compare(collection.at(0).id, 9);
+    }
+
+    function test_case_insensitive_sort() {
+        jsonModel.add([{id: 0, value: "a"}, {id: 1, value: "B"}, {id: 2, value: "c"}]);
+        collection.comparator = "value";
+        compare(collection.at(0).value, "B");
+
+        collection.caseSensitiveSort = false;
+        compare(collection.at(0).value, "a");
+        compare(collection.at(1).value, "B");
+    }
+
+    function test_filter() {
+        jsonModel.add(arrayData(10));
+        collection.filter = function(item) { return item.id % 2 == 0; };
+
+        compare(collection.count, 5);
+    }
+
+    function test_deferred_update() {
+        jsonModel.add(arrayData(10));
+        collection.comparator = "id";
+
+        collection.updateDelay = 0;
+        collection.descendingSort = true;
+        compare(collection.at(0).id, 0);
+
+        collection.flush();
+        compare(collection.at(0).id, 9);
+    }
+
+    function test_deferred_update_event_loop() {
+        jsonModel.add(arrayData(10));
+        collection.comparator = "id";
+
+        collection.updateDelay = 0;
+        collection.descendingSort = true;
+        collection.filter = function(item) { return item.id < 5; };
+        tryCompare(collection, "count", 5);
+        compare(collection.at(0).id, 4);
+    }
+
+    function test_single_sort_pass() {
+        jsonModel.add(arrayData(10));
+        collection.comparator = "id";
+        collection.statsEnabled = true;
+        collection.resetStats();
+
+        collection.updateDelay = 0;
+        collection.comparator = "value";
+        collection.descendingSort = true;
+        collection.flush();
+        compare(collection.stats().sortPass.calls, 1);
+        compare(collection.at(0).value, "foo9");
+
+        collection.descendingSort = false;
+        collection.caseSensitiveSort = false;
+        collection.flush();
+        compare(collection.stats().sortPass.calls, 2);
+        compare(collection.at(0).value, "foo0");
+
+        collection.statsEnabled = false;
+    }
+
+    function test_chained() {
+        jsonModel.add(arrayData(10));
+        collection.filter = function(item) { return item.id % 2 == 0; };
+
+        compare(chained.model, jsonModel);
+        compare(chained.count, 5);
+        compare(chained.at(0).id, 8);
+    }
+
+    function test_role_cache() {
+        jsonModel.roleCache = true;
+        jsonModel.add(arrayData(10));
+        collection.comparator = "value";
+        compare(collection.at(0).value, "foo0");
+
+        jsonModel.patch({id: 0, value: "zzz"});
+        compare(collection.at(9).value, "zzz");
+        jsonModel.remove(1);
+        compare(collection.at(0).value, "foo2");
+    }
+
+    function test_stats() {
+        jsonModel.add(arrayData(10));
+        jsonModel.statsEnabled = true;
+        collection.statsEnabled = true;
+        jsonModel.resetStats();
+        collection.resetStats();
+
+        collection.comparator = "value";
+        collection.reSort();
+        verify(jsonModel.stats().data.calls > 0);
+        verify(collection.stats().sortPass.calls > 0);
+        compare(collection.stats().comparator.calls, 0);
+
+        collection.comparator = function(a, b) { return a.id < b.id; };
+        verify(collection.stats().comparator.calls > 0);
+
+        collection.filter = function(item) { return true; };
+        verify(collection.stats().filter.calls >= 10);
+
+        jsonModel.add({id: 100, value: "x", statsRole: 1});
+        compare(jsonModel.stats().reset.calls, 1);
+        compare(collection.stats().reset.calls, 1);
+
+        jsonModel.statsEnabled = false;
+        collection.statsEnabled = false;
+    }
+}
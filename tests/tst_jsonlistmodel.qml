@@ -14,6 +14,24 @@ TestCase {
         id: jsonModel
     }
 
+    JsonListModel {
+        id: schemaModel
+        dynamicRoles: true
+        schemaInference: true
+    }
+
+    SignalSpy {
+        id: rolesSpy
+        target: schemaModel
+        signalName: "rolesChanged"
+    }
+
+    SignalSpy {
+        id: dataSpy
+        target: jsonModel
+        signalName: "dataChanged"
+    }
+
     SignalSpy {
         id: countSpy
         target: jsonModel
@@ -30,7 +48,9 @@ TestCase {
 
     function init() {
         jsonModel.clear();
+        schemaModel.clear();
         countSpy.clear();
+        dataSpy.clear();
     }
 
     function test_add_array() {
@@ -114,4 +134,118 @@ TestCase {
         jsonModel.clear();
         compare(jsonModel.count, 0);
     }
+
+    function test_schema_inference() {
+        schemaModel.statsEnabled = true;
+        schemaModel.resetStats();
+        schemaModel.add(arrayData(10));
+        compare(schemaModel.stats().roleExtraction.calls, 1);
+        verify(schemaModel.getRole("value") !== 0);
+        verify(schemaModel.getRole("extra.nested") === 0);
+
+        schemaModel.add([{id: 10, value: "a", extra: {nested: 1}}]);
+        compare(schemaModel.count, 11);
+        compare(schemaModel.stats().roleExtraction.calls, 2);
+        verify(schemaModel.getRole("extra") !== 0);
+        verify(schemaModel.getRole("extra.nested") !== 0);
+
+        // known shapes don't need their roles extracted again
+        rolesSpy.clear();
+        schemaModel.add([{id: 11, value: "b", extra: {nested: 2}},
+                         {id: 12, value: "c"}]);
+        compare(schemaModel.count, 13);
+        compare(schemaModel.stats().roleExtraction.calls, 2);
+        compare(rolesSpy.count, 0);
+        schemaModel.statsEnabled = false;
+    }
+
+    function test_patch_dotted() {
+        jsonModel.add({id: 1, value: "a", owner: {name: "x", age: 1}});
+        jsonModel.patch({id: 1, "owner.name": "y"});
+
+        var item = jsonModel.get(1);
+        compare(item.owner.name, "y");
+        compare(item.owner.age, 1);
+        verify(item["owner.name"] === undefined);
+    }
+
+    // the roles passed with dataChanged are checked in cpp/tst_jsonlistmodel
+    function test_patch_signals() {
+        jsonModel.add({id: 1, value: "a", status: "open", owner: {name: "x", age: 1}});
+        dataSpy.clear();
+
+        jsonModel.patch({id: 1, status: "done"});
+        compare(dataSpy.count, 1);
+        jsonModel.patch({id: 1, owner: {name: "y"}});
+        compare(dataSpy.count, 2);
+        jsonModel.patch({id: 1, "owner.name": "z"});
+        compare(dataSpy.count, 3);
+        compare(jsonModel.get(1).owner.name, "z");
+    }
+
+    function test_stats() {
+        jsonModel.statsEnabled = true;
+        jsonModel.resetStats();
+        jsonModel.add(arrayData(10));
+        jsonModel.add({id: 1, value: "a"});
+        jsonModel.statsEnabled = false;
+        jsonModel.add({id: 2, value: "b"});
+
+        compare(jsonModel.stats().add.calls, 2);
+        jsonModel.resetStats();
+        compare(jsonModel.stats().add.calls, 0);
+    }
+
+    function test_int_ids() {
+        compare(jsonModel.idType, "auto");
+        jsonModel.add(arrayData(10));
+        jsonModel.add({id: "3", value: "bar"});
+
+        compare(jsonModel.count, 10);
+        compare(jsonModel.get(3).value, "bar");
+        compare(jsonModel.get("5").value, "foo5");
+
+        jsonModel.remove("9");
+        compare(jsonModel.count, 9);
+
+        // falls back to string ids
+        jsonModel.add({id: "abc", value: "baz"});
+        compare(jsonModel.count, 10);
+        compare(jsonModel.get(5).value, "foo5");
+        compare(jsonModel.get("abc").value, "baz");
+    }
+
+    function test_remove_middle() {
+        jsonModel.add(arrayData(10));
+        jsonModel.remove(3);
+        compare(jsonModel.at(3).id, 4);
+
+        jsonModel.add({id: 5, value: "bar"});
+        compare(jsonModel.count, 9);
+        compare(jsonModel.at(4).value, "bar");
+        compare(jsonModel.get(5).value, "bar");
+
+        jsonModel.add({id: "abc", value: "baz"});
+        jsonModel.remove(0);
+        compare(jsonModel.at(3).value, "bar");
+        compare(jsonModel.get("abc").value, "baz");
+    }
+
+    function test_patch() {
+        jsonModel.add({id: 1, value: "a", status: "open", owner: {name: "x", age: 1}});
+        jsonModel.patch({id: 1, status: "done", owner: {name: "y"}});
+
+        compare(jsonModel.count, 1);
+        var item = jsonModel.get(1);
+        compare(item.value, "a");
+        compare(item.status, "done");
+        compare(item.owner.name, "y");
+        compare(item.owner.age, 1);
+
+        jsonModel.patch([{id: 1, value: "b"}, {id: 2, value: "c"}]);
+        compare(jsonModel.count, 2);
+        compare(jsonModel.get(1).value, "b");
+        compare(jsonModel.get(1).status, "done");
+        compare(jsonModel.get(2).value, "c");
+    }
 }